@@ -2,6 +2,9 @@
 #undef CMK_USE_TCP
 #define CMK_USE_TCP                                         1
 
+/* Vector sends go out as one sendmsg per fragment, see machine-tcp.C */
+#define CMK_LRTS_VECTOR_SEND                                1
+
 #if CMK_SMP
 #undef CMK_USE_POLL
 #endif
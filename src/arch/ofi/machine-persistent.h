@@ -0,0 +1,67 @@
+#ifndef MACHINE_PERSISTENT_H
+#define MACHINE_PERSISTENT_H
+
+/** @file
+ * Persistent communication over OFI RMA writes
+ * @ingroup Machine
+ */
+
+/**
+ * \addtogroup Machine
+*/
+/*@{*/
+
+#include <rdma/fabric.h>
+
+/* Smaller messages go out eagerly anyway */
+extern int persistMinSize;
+#define PERSIST_MIN_SIZE                persistMinSize
+#define PERSIST_BUFFERS_NUM             1
+
+#define PERSIST_SEQ                     0xFFFFFFF
+
+typedef struct  _PersistentBuf {
+  void *destAddress;
+  uint64_t key;
+  struct fid_mr *mr;                              /* valid on the receiver */
+} PersistentBuf;
+
+typedef struct _PersistentSendsTable {
+  int destPE;
+  int sizeMax;
+  PersistentHandle   destHandle;
+  PersistentBuf     destBuf[PERSIST_BUFFERS_NUM];
+  void *messageBuf;
+  int messageSize;
+  struct _PersistentSendsTable *prev, *next;
+  int addrIndex;
+  int inFlight;         /* the receiver has not copied the last write out yet */
+  void *pending;        /* CdsFifo of writes waiting for the ack; comm thread only */
+} PersistentSendsTable;
+
+typedef struct _PersistentReceivesTable {
+  PersistentBuf     destBuf[PERSIST_BUFFERS_NUM];
+  int sizeMax;
+  size_t               index;
+  struct _PersistentReceivesTable *prev, *next;
+  int           addrIndex;
+} PersistentReceivesTable;
+
+CpvExtern(PersistentReceivesTable *, persistentReceivesTableHead);
+CpvExtern(PersistentReceivesTable *, persistentReceivesTableTail);
+
+CpvExtern(PersistentHandle *, phs);
+CpvExtern(int, phsSize);
+CpvExtern(int, curphs);
+
+PersistentHandle getPersistentHandle(PersistentHandle h, int toindex);
+void *PerAlloc(int size);
+void PerFree(char *msg);
+void swapSendSlotBuffers(PersistentSendsTable *slot);
+void swapRecvSlotBuffers(PersistentReceivesTable *slot);
+void setupRecvSlot(PersistentReceivesTable *slot, int maxBytes);
+void clearRecvSlot(PersistentReceivesTable *slot);
+
+/*@}*/
+
+#endif
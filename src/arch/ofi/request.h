@@ -36,6 +36,8 @@ typedef enum request_state
 struct OFIRmaHeader;
 struct OFIRmaAck;
 struct OFILongMsg;
+struct OFIPersistWrite;
+struct OFIPersistMsg;
 
 /**
  * OFI Request
@@ -57,6 +59,8 @@ struct OFILongMsg;
  *      - short_msg: used when a short message was sent
  *      - rma_ncpy_info: used when an RMA Read operation completed through the Nocopy API
  *      - rma_ncpy_ack: used when an OFIRmaAck was received through the Nocopy API
+ *      - persist_write: used when an RMA Write into a persistent buffer is queued or completed
+ *      - persist_msg: used when an OFIPersistMsg was sent
  */
 typedef struct OFIRequest
 {
@@ -80,6 +84,10 @@ typedef struct OFIRequest
 #if CMK_ONESIDED_IMPL
         void                *rma_ncpy_info;
         void                *rma_ncpy_ack;
+#endif
+#if CMK_PERSISTENT_COMM
+        struct OFIPersistWrite *persist_write;
+        struct OFIPersistMsg   *persist_msg;
 #endif
     } data;
 } OFIRequest;
@@ -142,6 +142,16 @@ void * LRTSQueuePop(LRTSQueue    queue)
   return (void *) e;
 }
 
+//Pop up to max messages into out and return how many were popped
+int LRTSQueuePopBatch(LRTSQueue queue, char **out, int max)
+{
+  int n = 0;
+  void *e;
+  while (n < max && (e = LRTSQueuePop(queue)) != NULL)
+    out[n++] = (char *) e;
+  return n;
+}
+
 int LRTSQueueEmpty (LRTSQueue queue) {
   return ( (PCQueueLength(queue->_overflowQ) == 0) &&
 	   (queue->_l2state->Producer == queue->_l2state->Consumer) );
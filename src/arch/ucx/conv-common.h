@@ -22,7 +22,7 @@
  * - startid, redID
  * - rank is needed by broadcast
  */
-#define CMK_MSG_HEADER_UNIQUE    CmiUInt4 size; CmiUInt2 rank,hdl,xhdl,info,redID; CmiInt4 root; CmiUInt1 zcMsgType:4, cmaMsgType:2, nokeep:1;
+#define CMK_MSG_HEADER_UNIQUE    CmiUInt4 size; CmiUInt2 rank,hdl,xhdl,info,redID; CmiInt4 root; CmiUInt1 zcMsgType:4, cmaMsgType:2, nokeep:1, compress:1;
 
 #define CMK_MSG_HEADER_BASIC  CMK_MSG_HEADER_EXT
 #define CMK_MSG_HEADER_EXT            { CMK_MSG_HEADER_UNIQUE }
@@ -75,6 +75,9 @@
 
 #define CMK_ONESIDED_IMPL                                  1
 
+/* Vector sends use UCX iov datatypes instead of packing */
+#define CMK_LRTS_VECTOR_SEND                               1
+
 /* Should be enough to fit UCP memh + rkey */
 #define CMK_NOCOPY_DIRECT_BYTES                            256
 
@@ -0,0 +1,73 @@
+#ifndef MACHINE_PERSISTENT_H
+#define MACHINE_PERSISTENT_H
+
+/** @file
+ * Persistent communication over UCX RMA
+ * @ingroup Machine
+ */
+
+/**
+ * \addtogroup Machine
+*/
+/*@{*/
+
+#include <ucp/api/ucp.h>
+
+/* Smaller messages go out eagerly anyway */
+extern int persistMinSize;
+#define PERSIST_MIN_SIZE                persistMinSize
+#define PERSIST_BUFFERS_NUM             1
+
+#define PERSIST_SEQ                     0xFFFFFFF
+
+#define UCX_PERSIST_MAX_RKEY_SIZE       256
+
+typedef struct  _PersistentBuf {
+  void *destAddress;
+  ucp_mem_h memh;                                 /* valid on the receiver */
+  char packedRkey[UCX_PERSIST_MAX_RKEY_SIZE];
+} PersistentBuf;
+
+typedef struct _PersistentSendsTable {
+  int destPE;
+  int sizeMax;
+  PersistentHandle   destHandle;
+  PersistentBuf     destBuf[PERSIST_BUFFERS_NUM];
+  void *messageBuf;
+  int messageSize;
+  struct _PersistentSendsTable *prev, *next;
+  int addrIndex;
+  ucp_rkey_h rkey;      /* unpacked by the comm thread on the first put */
+  int inFlight;         /* the receiver has not copied the last put out yet */
+  void *pending;        /* CdsFifo of sends waiting for the ack; comm thread only */
+} PersistentSendsTable;
+
+typedef struct _PersistentReceivesTable {
+  PersistentBuf     destBuf[PERSIST_BUFFERS_NUM];
+  int sizeMax;
+  size_t               index;
+  struct _PersistentReceivesTable *prev, *next;
+  int           addrIndex;
+} PersistentReceivesTable;
+
+CpvExtern(PersistentReceivesTable *, persistentReceivesTableHead);
+CpvExtern(PersistentReceivesTable *, persistentReceivesTableTail);
+
+CpvExtern(PersistentHandle *, phs);
+CpvExtern(int, phsSize);
+CpvExtern(int, curphs);
+
+PersistentHandle getPersistentHandle(PersistentHandle h, int toindex);
+void *PerAlloc(int size);
+void PerFree(char *msg);
+void swapSendSlotBuffers(PersistentSendsTable *slot);
+void swapRecvSlotBuffers(PersistentReceivesTable *slot);
+void setupRecvSlot(PersistentReceivesTable *slot, int maxBytes);
+void clearRecvSlot(PersistentReceivesTable *slot);
+
+void UcxPersistentPut(PersistentSendsTable *slot, int destNode, int size, char *msg);
+void UcxPersistentRecvd(char *buf);
+
+/*@}*/
+
+#endif
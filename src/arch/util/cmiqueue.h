@@ -6,12 +6,14 @@
 #define CMIQueuePush    LRTSQueuePush
 #define CMIQueueCreate  LRTSQueueCreate
 #define CMIQueuePop     LRTSQueuePop
+#define CMIQueuePopBatch LRTSQueuePopBatch
 #define CMIQueueEmpty   LRTSQueueEmpty
 #else
 #define CMIQueue PCQueue
 #define CMIQueuePush    PCQueuePush
 #define CMIQueueCreate  PCQueueCreate
 #define CMIQueuePop     PCQueuePop
+#define CMIQueuePopBatch PCQueuePopBatch
 #define CMIQueueEmpty   PCQueueEmpty
 #endif
 
@@ -8,6 +8,14 @@ void LrtsPrepareEnvelope(char *msg, int size);
 /* The machine-specific send function */
 CmiCommHandle LrtsSendFunc(int destNode, int destPE, int size, char *msg, int mode);
 
+#if CMK_LRTS_VECTOR_SEND
+/* Sends one message made of n pieces without gathering them into one buffer.
+   The first piece starts with the Converse header. Every piece was CmiAlloc'ed
+   and is CmiFree'd by the machine layer once it is sent; sizes and msgs are
+   not kept. */
+CmiCommHandle LrtsSendVectorFunc(int destNode, int destPE, int n, int *sizes, char **msgs, int mode);
+#endif
+
 void LrtsSyncListSendFn(int npes, const int *pes, int len, char *msg);
 CmiCommHandle LrtsAsyncListSendFn(int npes, const int *pes, int len, char *msg);
 void LrtsFreeListSendFn(int npes, const int *pes, int len, char *msg);
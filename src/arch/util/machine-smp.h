@@ -33,9 +33,15 @@ typedef struct {
 
 #elif CMK_SHARED_VARS_POSIX_THREADS_SMP
 
+#include <atomic>
+
+/*Microseconds a PE spins before blocking with +CmiBlockOnIdle*/
+#define CMI_IDLE_SPIN_US_DEFAULT 50
+
 typedef struct {
   volatile int hasMessages; /*Is there a message waiting?*/
   volatile int isSleeping; /*Are we asleep in this cond?*/
+  std::atomic<int> blocked; /*Futex word: 1 while blocked with +CmiBlockOnIdle*/
   pthread_mutex_t mutex;
   pthread_cond_t cond;
 } CmiIdleLock;
@@ -66,17 +72,42 @@ typedef struct {
 #endif
 #endif
 
+/*
+ * Messages from the communication thread reach each worker through an
+ * SPSC ring of its own (commRecv), since the communication thread is the
+ * only producer on that path. Worker-to-worker sends still use recv, and
+ * the worker takes turns between the two.
+ */
+#ifndef CMK_SMP_COMM_RING
+#define CMK_SMP_COMM_RING (CMK_SMP && !CMK_SMP_NO_COMMTHD && !CMK_MULTICORE && !CMK_MACH_SPECIALIZED_QUEUE && !CMK_SMP_MULTIQ)
+#endif
+
+/*
+ * With +immCommThread, immediate messages are handled by the communication
+ * thread only, and reach it through a lock-free inbox (see immediate.C).
+ */
+#ifndef CMK_IMM_INBOX
+#define CMK_IMM_INBOX (CMK_IMMEDIATE_MSG && CMK_SMP && !CMK_SMP_NO_COMMTHD && !CMK_MULTICORE)
+#endif
+
 /************************************************************
  *
  * Processor state structure
  *
  ************************************************************/
 
-typedef struct CmiStateStruct
+/* Each rank's state gets cache lines of its own, since other threads push
+   into its recv queue and poke its idle lock */
+typedef struct alignas(CMI_CACHE_LINE_SIZE) CmiStateStruct
 {
   int pe, rank;
 #if !CMK_SMP_MULTIQ
   CMIQueue recv; 
+#if CMK_SMP_COMM_RING
+  SPSCRing commRecv;   /* filled by the communication thread only */
+  void *commPending;   /* communication thread only: CdsFifo of messages waiting for room in commRecv */
+  int recvFirst;       /* worker only: poll recv before commRecv next time */
+#endif
 #else
   CMIQueue recv[MULTIQ_GRPSIZE];
   int myGrpIdx;
@@ -37,6 +37,8 @@
 
 #if CMK_SMP
 #include <atomic>
+#include <new>
+#include <stdlib.h>
 #define CMK_SMP_volatile volatile
 #define CMK_SMP_align alignas(CMI_CACHE_LINE_SIZE)
 #else
@@ -52,6 +54,7 @@
 typedef int PCQueue_CmiMemoryAtomicInt;
 #define PCQueue_CmiMemoryAtomicIncrement(k, mem) ((k)++)
 #define PCQueue_CmiMemoryAtomicDecrement(k, mem) ((k)--)
+#define PCQueue_CmiMemoryAtomicSubtract(k, n, mem) ((k) -= (n))
 #define PCQueue_CmiMemoryAtomicLoad(k, mem)      (k)
 #define PCQueue_CmiMemoryAtomicStore(k, v, mem)  ((k) = (v))
 #else
@@ -60,6 +63,7 @@ typedef int PCQueue_CmiMemoryAtomicInt;
 using PCQueue_CmiMemoryAtomicInt = std::atomic<int>;
 #define PCQueue_CmiMemoryAtomicIncrement(k, mem) std::atomic_fetch_add_explicit(&(k), 1, (mem))
 #define PCQueue_CmiMemoryAtomicDecrement(k, mem) std::atomic_fetch_sub_explicit(&(k), 1, (mem))
+#define PCQueue_CmiMemoryAtomicSubtract(k, n, mem) std::atomic_fetch_sub_explicit(&(k), (n), (mem))
 #define PCQueue_CmiMemoryAtomicLoad(k, mem)      std::atomic_load_explicit(&(k), (mem))
 #define PCQueue_CmiMemoryAtomicStore(k, v, mem)  std::atomic_store_explicit(&(k), (v), (mem))
 #endif
@@ -198,6 +202,42 @@ static char *PCQueuePop(PCQueue Q)
     }
 }
 
+/* Pop up to max entries into out, returning how many were popped. The
+   whole batch is taken under one lock acquisition and the length is
+   updated once, instead of once per entry as with PCQueuePop. */
+static int PCQueuePopBatch(PCQueue Q, char **out, int max)
+{
+  CircQueue circ; int pull; char *data; int n = 0;
+
+    if (PCQueue_CmiMemoryAtomicLoad(Q->len, std::memory_order_relaxed) == 0) return 0;
+#if CMK_PCQUEUE_LOCK
+    CmiLock(Q->lock);
+#endif
+    while (n < max) {
+      circ = Q->head;
+      pull = circ->pull;
+      data = PCQueue_CmiMemoryAtomicLoad(circ->data[pull], std::memory_order_acquire);
+      if (!data) break; /* empty, or the producer is still filling this slot */
+
+      circ->pull = (pull + 1);
+      circ->data[pull] = 0;
+      if (pull == PCQueueSize - 1) { /* same buffer switch as in PCQueuePop */
+        PCQueue_CmiMemoryReadFence();
+        Q->head = circ-> next;
+        CmiAssert(Q->head != NULL);
+
+        free(circ);
+      }
+      out[n++] = data;
+    }
+    if (n > 0)
+      PCQueue_CmiMemoryAtomicSubtract(Q->len, n, std::memory_order_release);
+#if CMK_PCQUEUE_LOCK
+    CmiUnlock(Q->lock);
+#endif
+    return n;
+}
+
 static void PCQueuePush(PCQueue Q, char *data)
 {
   CircQueue circ, circ1; int push;
@@ -353,6 +393,37 @@ static char *PCQueuePop(PCQueue Q)
 
       return data;
 }
+/* Pop up to max entries into out, returning how many were popped. */
+static int PCQueuePopBatch(PCQueue Q, char **out, int max)
+{
+    char *data; int n = 0;
+
+#if CMK_PCQUEUE_LOCK
+    CmiLock(Q->lock);
+#endif
+
+    while (n < max) {
+      data = *(Q->head);
+      PCQueue_CmiMemoryReadFence();
+      if (!data) break;
+
+      *(Q->head) = 0;
+      Q->head++;
+
+      if (Q->head == (char **)Q->bufEnd ) {
+	Q->head = (char **)Q->data;
+      }
+      out[n++] = data;
+    }
+    if (n > 0)
+      PCQueue_CmiMemoryAtomicSubtract(Q->len, n, std::memory_order_release);
+
+#if CMK_PCQUEUE_LOCK
+      CmiUnlock(Q->lock);
+#endif
+
+      return n;
+}
 static void PCQueuePush(PCQueue Q, char *data)
 {
 #if CMK_PCQUEUE_LOCK || CMK_PCQUEUE_PUSH_LOCK
@@ -396,6 +467,106 @@ static void PCQueuePush(PCQueue Q, char *data)
 }
 #endif
 
+#if CMK_SMP
+/*
+ * SPSCRing
+ *
+ * Bounded single-producer/single-consumer ring of char *, used for the
+ * messages the communication thread hands to each worker. Push and pop
+ * are wait-free: the producer only writes tail and the consumer only
+ * writes head. Each side keeps a private copy of the other side's index
+ * and only rereads the shared one when the copy says the ring is full
+ * (or empty), so in the steady state a push or pop touches no cache line
+ * written by the other thread except the slot itself.
+ *
+ * Pushes fail when the ring is full; the caller has to keep the entry until
+ * the consumer makes room.
+ */
+#define SPSCRingSize 0x400 /* Must be a power of two */
+#define SPSCRingWrap (SPSCRingSize - 1)
+
+typedef struct SPSCRingStruct
+{
+  CMK_SMP_align std::atomic<unsigned int> head; /* next slot to pop, written by the consumer */
+  unsigned int cachedTail;                      /* consumer's copy of tail */
+  CMK_SMP_align std::atomic<unsigned int> tail; /* next slot to push, written by the producer */
+  unsigned int cachedHead;                      /* producer's copy of head */
+  CMK_SMP_align char *data[SPSCRingSize];
+}
+*SPSCRing;
+
+/* Rings live as long as the process, like the recv queues they sit next to */
+static SPSCRing SPSCRingCreate(void)
+{
+  /* Plain new need not honor the cache-line alignment before C++17 */
+  void *mem;
+#ifdef _WIN32
+  mem = _aligned_malloc(sizeof(struct SPSCRingStruct), CMI_CACHE_LINE_SIZE);
+#else
+  if (posix_memalign(&mem, CMI_CACHE_LINE_SIZE, sizeof(struct SPSCRingStruct)) != 0)
+    mem = NULL;
+#endif
+  if (mem == NULL)
+    CmiAbort("SPSCRingCreate: out of memory");
+  SPSCRing Q = new (mem) SPSCRingStruct;
+  std::atomic_store_explicit(&Q->head, 0u, std::memory_order_relaxed);
+  std::atomic_store_explicit(&Q->tail, 0u, std::memory_order_relaxed);
+  Q->cachedTail = Q->cachedHead = 0;
+  return Q;
+}
+
+static int SPSCRingEmpty(SPSCRing Q)
+{
+  return std::atomic_load_explicit(&Q->head, std::memory_order_relaxed) ==
+         std::atomic_load_explicit(&Q->tail, std::memory_order_acquire);
+}
+
+/* Producer only: push up to n entries of in, returning how many fit */
+static int SPSCRingPushBatch(SPSCRing Q, char **in, int n)
+{
+  unsigned int tail = std::atomic_load_explicit(&Q->tail, std::memory_order_relaxed);
+  unsigned int room = SPSCRingSize - (tail - Q->cachedHead);
+  if (room < (unsigned int)n) {
+    Q->cachedHead = std::atomic_load_explicit(&Q->head, std::memory_order_acquire);
+    room = SPSCRingSize - (tail - Q->cachedHead);
+    if (room < (unsigned int)n) n = room;
+  }
+  for (int i = 0; i < n; i++)
+    Q->data[(tail + i) & SPSCRingWrap] = in[i];
+  std::atomic_store_explicit(&Q->tail, tail + n, std::memory_order_release);
+  return n;
+}
+
+/* Producer only: returns 0 if the ring is full */
+static int SPSCRingPush(SPSCRing Q, char *data)
+{
+  return SPSCRingPushBatch(Q, &data, 1);
+}
+
+/* Consumer only: pop up to max entries into out, returning how many */
+static int SPSCRingPopBatch(SPSCRing Q, char **out, int max)
+{
+  unsigned int head = std::atomic_load_explicit(&Q->head, std::memory_order_relaxed);
+  unsigned int avail = Q->cachedTail - head;
+  if (avail < (unsigned int)max) {
+    Q->cachedTail = std::atomic_load_explicit(&Q->tail, std::memory_order_acquire);
+    avail = Q->cachedTail - head;
+  }
+  int n = (avail < (unsigned int)max) ? (int)avail : max;
+  for (int i = 0; i < n; i++)
+    out[i] = Q->data[(head + i) & SPSCRingWrap];
+  std::atomic_store_explicit(&Q->head, head + n, std::memory_order_release);
+  return n;
+}
+
+/* Consumer only: returns NULL if the ring is empty */
+static char *SPSCRingPop(SPSCRing Q)
+{
+  char *data;
+  return SPSCRingPopBatch(Q, &data, 1) ? data : NULL;
+}
+#endif
+
 // CMK_LOCKLESS_QUEUE (disabled by default)
 #if CMK_LOCKLESS_QUEUE
 
@@ -1030,6 +1201,17 @@ static char *MPMCQueuePop(MPMCQueue Q)
   return data;
 }
 
+/* Pop up to max entries into out, returning how many were popped. Every
+   entry is still claimed separately, as other consumers may be popping. */
+static int MPMCQueuePopBatch(MPMCQueue Q, char **out, int max)
+{
+  int n = 0;
+  char *data;
+  while (n < max && (data = MPMCQueuePop(Q)) != NULL)
+    out[n++] = data;
+  return n;
+}
+
 static void MPMCQueuePush(MPMCQueue Q, void *data)
 {
   unsigned int push = std::atomic_fetch_add_explicit(&Q->push, 1u, std::memory_order_release);
@@ -188,10 +188,6 @@ inline void _CldNodeEnqueue(int node, void *msg, int infofn) {
 CkpvExtern(std::vector<void *>, chare_objs);
 #endif
 
-#include <unordered_map>
-typedef std::unordered_map<CmiUInt8, ArrayElement*> ArrayObjMap;
-CkpvExtern(ArrayObjMap, array_objs);
-
 /// A set of "Virtual ChareID"'s
 class VidBlock {
     enum VidState : uint8_t {FILLED, UNFILLED};
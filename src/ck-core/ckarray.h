@@ -441,6 +441,11 @@ inline int* CkArrayListener::ckGetData(ArrayElement* el) const
   return &el->listenerData[dataOffset];
 }
 
+/// PE-level map of array element IDs to the elements, for fast delivery
+/// (declared in ck.C). Entries move on insert and erase, see ckflathash.h.
+typedef CkFlatHashMap<CmiUInt8, ArrayElement*> ArrayObjMap;
+CkpvExtern(ArrayObjMap, array_objs);
+
 /**An ArrayElementT is a utility class where you are
  * constrained to a "thisIndex" of some fixed-sized type T.
  */
@@ -658,7 +663,7 @@ class CkArray : public CkReductionMgr
   CkCallback initCallback;
   CProxy_CkArray thisProxy;
   // Separate mapping and storing the element pointers to speed iteration in broadcast
-  std::unordered_map<CmiUInt8, unsigned int> localElems;
+  CkElementIdMap<unsigned int> localElems;
   std::vector<CkMigratable*> localElemVec;
 
   UShort recvBroadcastEpIdx;
@@ -751,14 +756,14 @@ public:
   }
 
   inline unsigned int getEltLocalIndex(const CmiUInt8 id) {
-    const auto itr = localElems.find(id);
-    return ( itr == localElems.end() ? -1 : itr->second);
+    const unsigned int* offset = localElems.find(id);
+    return ( offset == NULL ? -1 : *offset);
   }
 
   virtual CkMigratable* getEltFromArrMgr(const CmiUInt8 id)
   {
-    const auto itr = localElems.find(id);
-    return (itr == localElems.end() ? NULL : localElemVec[itr->second]);
+    const unsigned int* offset = localElems.find(id);
+    return (offset == NULL ? NULL : localElemVec[*offset]);
   }
   virtual void putEltInArrMgr(const CmiUInt8 id, CkMigratable* elt)
   {
@@ -767,11 +772,11 @@ public:
   }
   virtual void eraseEltFromArrMgr(const CmiUInt8 id)
   {
-    auto itr = localElems.find(id);
-    if (itr != localElems.end())
+    const unsigned int* found = localElems.find(id);
+    if (found != NULL)
     {
-      unsigned int offset = itr->second;
-      localElems.erase(itr);
+      unsigned int offset = *found;
+      localElems.erase(id);
       // Do not delete the CkMigratable itself (unlike in deleteElt)
 
       if (offset != localElemVec.size() - 1)
@@ -787,11 +792,11 @@ public:
 
   void deleteElt(const CmiUInt8 id)
   {
-    auto itr = localElems.find(id);
-    if (itr != localElems.end())
+    const unsigned int* found = localElems.find(id);
+    if (found != NULL)
     {
-      unsigned int offset = itr->second;
-      localElems.erase(itr);
+      unsigned int offset = *found;
+      localElems.erase(id);
       delete localElemVec[offset];
 
       if (offset != localElemVec.size() - 1)
@@ -0,0 +1,376 @@
+/*
+Flat hash tables for the location and array managers.
+
+CkFlatHashMap is an open-addressing table with Robin Hood probing.  All
+entries live in one array of slots, with a byte per slot recording how
+far the entry sits from its home slot, so a lookup reads a few adjacent
+slots rather than chasing list nodes.  Entries move when others are
+inserted or erased, so both invalidate pointers and iterators into the
+table.
+
+CkElementIdMap maps element IDs to values.  It keeps a run of nearly
+consecutive IDs in a plain vector (the "dense window"), and any other
+ID in a CkFlatHashMap.  The elements a block map places on a PE have
+consecutive IDs, so for a 1D array the lookup is a bounds check and a
+load.
+*/
+#ifndef _CKFLATHASH_H
+#define _CKFLATHASH_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <functional>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+template <class K, class V, class Hash = std::hash<K>, class Eq = std::equal_to<K> >
+class CkFlatHashMap
+{
+public:
+  typedef K key_type;
+  typedef V mapped_type;
+  typedef std::pair<K, V> value_type;
+
+  template <bool Const>
+  class iter
+  {
+    friend class CkFlatHashMap;
+    template <bool> friend class iter;
+    typedef typename std::conditional<Const, const CkFlatHashMap, CkFlatHashMap>::type map_t;
+    typedef typename std::conditional<Const, const value_type, value_type>::type elem_t;
+    map_t* m;
+    size_t i;
+    iter(map_t* m_, size_t i_) : m(m_), i(i_) {}
+
+  public:
+    iter() : m(NULL), i(0) {}
+    // iterator converts to const_iterator
+    template <bool C, class = typename std::enable_if<Const && !C>::type>
+    iter(const iter<C>& o) : m(o.m), i(o.i) {}
+
+    elem_t& operator*() const { return m->slots[i]; }
+    elem_t* operator->() const { return &m->slots[i]; }
+    iter& operator++()
+    {
+      i = m->nextUsed(i + 1);
+      return *this;
+    }
+    iter operator++(int)
+    {
+      iter old = *this;
+      ++*this;
+      return old;
+    }
+    bool operator==(const iter& o) const { return i == o.i; }
+    bool operator!=(const iter& o) const { return i != o.i; }
+  };
+  typedef iter<false> iterator;
+  typedef iter<true> const_iterator;
+
+  CkFlatHashMap() : slots(NULL), dist(NULL), mask(0), shift(64), nEntries(0) {}
+  ~CkFlatHashMap()
+  {
+    clear();
+    ::operator delete(slots);
+    free(dist);
+  }
+  CkFlatHashMap(const CkFlatHashMap&) = delete;
+  CkFlatHashMap& operator=(const CkFlatHashMap&) = delete;
+
+  size_t size() const { return nEntries; }
+  bool empty() const { return nEntries == 0; }
+
+  iterator begin() { return iterator(this, nextUsed(0)); }
+  iterator end() { return iterator(this, capacity()); }
+  const_iterator begin() const { return const_iterator(this, nextUsed(0)); }
+  const_iterator end() const { return const_iterator(this, capacity()); }
+
+  iterator find(const K& key)
+  {
+    size_t i = findSlot(key);
+    return iterator(this, i == npos ? capacity() : i);
+  }
+  const_iterator find(const K& key) const
+  {
+    size_t i = findSlot(key);
+    return const_iterator(this, i == npos ? capacity() : i);
+  }
+  size_t count(const K& key) const { return findSlot(key) != npos; }
+
+  // Insert key with a value built from args, unless key is already there
+  template <class... Args>
+  std::pair<iterator, bool> emplace(const K& key, Args&&... args)
+  {
+    size_t i = findSlot(key);
+    if (i != npos) return std::make_pair(iterator(this, i), false);
+    if ((nEntries + 1) * 8 > capacity() * 7)  // keep the load under 7/8
+      rehash(capacity() ? 2 * capacity() : MIN_CAPACITY);
+    i = place(value_type(std::piecewise_construct, std::forward_as_tuple(key),
+                         std::forward_as_tuple(std::forward<Args>(args)...)));
+    if (i == npos) i = findSlot(key);
+    return std::make_pair(iterator(this, i), true);
+  }
+  V& operator[](const K& key) { return emplace(key).first->second; }
+
+  void erase(const_iterator it) { eraseSlot(it.i); }
+  size_t erase(const K& key)
+  {
+    size_t i = findSlot(key);
+    if (i == npos) return 0;
+    eraseSlot(i);
+    return 1;
+  }
+
+  void clear()
+  {
+    for (size_t i = 0; i < capacity(); i++)
+    {
+      if (dist[i])
+      {
+        slots[i].~value_type();
+        dist[i] = 0;
+      }
+    }
+    nEntries = 0;
+  }
+
+  // Make room for n entries without growing
+  void reserve(size_t n)
+  {
+    size_t c = MIN_CAPACITY;
+    while (c * 7 < n * 8) c *= 2;
+    if (c > capacity()) rehash(c);
+  }
+
+private:
+  enum { MIN_CAPACITY = 16, MAX_DIST = 255 };
+  static const size_t npos = (size_t)-1;
+
+  value_type* slots;
+  uint8_t* dist;  // distance from the home slot + 1, or 0 if the slot is empty
+  size_t mask;    // capacity - 1; the capacity is a power of two
+  int shift;      // 64 - log2(capacity)
+  size_t nEntries;
+  Hash hasher;
+  Eq eq;
+
+  size_t capacity() const { return slots ? mask + 1 : 0; }
+
+  size_t nextUsed(size_t i) const
+  {
+    while (i < capacity() && !dist[i]) i++;
+    return i;
+  }
+
+  // Fibonacci hashing, so that IDs and index hashes that differ only in
+  // their high bits still spread over the table
+  size_t homeSlot(const K& key) const
+  {
+    return (size_t)(((uint64_t)hasher(key) * 0x9E3779B97F4A7C15ull) >> shift);
+  }
+
+  size_t findSlot(const K& key) const
+  {
+    if (nEntries == 0) return npos;
+    size_t i = homeSlot(key);
+    // Robin Hood order: past the first entry closer to its home, key is absent
+    for (unsigned d = 1; dist[i] >= d; d++, i = (i + 1) & mask)
+    {
+      if (dist[i] == d && eq(slots[i].first, key)) return i;
+    }
+    return npos;
+  }
+
+  // Put an entry that is known to be absent into the table, and return
+  // its slot, or npos if the table had to grow on the way
+  size_t place(value_type&& v)
+  {
+    size_t i = homeSlot(v.first), placed = npos;
+    unsigned d = 1;
+    for (;;)
+    {
+      if (dist[i] == 0)
+      {
+        new (&slots[i]) value_type(std::move(v));
+        dist[i] = d;
+        nEntries++;
+        return placed == npos ? i : placed;
+      }
+      if (dist[i] < d)
+      {  // Take the slot of an entry that is closer to its home
+        std::swap(v, slots[i]);
+        unsigned t = dist[i];
+        dist[i] = d;
+        d = t;
+        if (placed == npos) placed = i;
+      }
+      i = (i + 1) & mask;
+      if (++d == MAX_DIST)
+      {
+        rehash(2 * capacity());
+        place(std::move(v));
+        return npos;
+      }
+    }
+  }
+
+  // Backward-shift deletion: pull the following entries of the run one
+  // slot closer to their homes, so no tombstones are needed
+  void eraseSlot(size_t i)
+  {
+    slots[i].~value_type();
+    dist[i] = 0;
+    nEntries--;
+    for (size_t j = (i + 1) & mask; dist[j] > 1; i = j, j = (j + 1) & mask)
+    {
+      new (&slots[i]) value_type(std::move(slots[j]));
+      slots[j].~value_type();
+      dist[i] = dist[j] - 1;
+      dist[j] = 0;
+    }
+  }
+
+  void rehash(size_t newCapacity)
+  {
+    value_type* oldSlots = slots;
+    uint8_t* oldDist = dist;
+    size_t oldCapacity = capacity();
+
+    slots = (value_type*)::operator new(newCapacity * sizeof(value_type));
+    dist = (uint8_t*)calloc(newCapacity, 1);
+    mask = newCapacity - 1;
+    shift = 64;
+    for (size_t c = newCapacity; c > 1; c >>= 1) shift--;
+    nEntries = 0;
+
+    for (size_t i = 0; i < oldCapacity; i++)
+    {
+      if (oldDist[i])
+      {
+        place(std::move(oldSlots[i]));
+        oldSlots[i].~value_type();
+      }
+    }
+    ::operator delete(oldSlots);
+    free(oldDist);
+  }
+};
+
+template <class V>
+class CkElementIdMap
+{
+public:
+  CkElementIdMap() : base(0), denseCount(0), denseOK(false) {}
+
+  // Allow IDs to go into the dense window
+  void setDense(bool on) { denseOK = on; }
+
+  size_t size() const { return denseCount + table.size(); }
+
+  // Return the value stored for id, or NULL if there is none
+  V* find(CmiUInt8 id)
+  {
+    CmiUInt8 off = id - base;
+    if (off < dense.size() && used[off]) return &dense[off];
+    if (table.empty()) return NULL;
+    typename Table::iterator it = table.find(id);
+    return it == table.end() ? NULL : &it->second;
+  }
+  const V* find(CmiUInt8 id) const { return const_cast<CkElementIdMap*>(this)->find(id); }
+
+  V& operator[](CmiUInt8 id)
+  {
+    if (id - base >= dense.size() && !(denseOK && widen(id))) return table[id];
+    CmiUInt8 off = id - base;
+    if (!used[off])
+    {
+      // The window may have grown over an ID that went into the table
+      if (!table.empty())
+      {
+        typename Table::iterator it = table.find(id);
+        if (it != table.end()) return it->second;
+      }
+      used[off] = 1;
+      dense[off] = V();
+      denseCount++;
+    }
+    return dense[off];
+  }
+
+  bool erase(CmiUInt8 id)
+  {
+    CmiUInt8 off = id - base;
+    if (off < dense.size() && used[off])
+    {
+      used[off] = 0;
+      dense[off] = V();
+      if (--denseCount == 0)
+      {
+        dense.clear();
+        used.clear();
+      }
+      return true;
+    }
+    return table.erase(id) != 0;
+  }
+
+  // Call f(id, value) for every entry; f must not modify the map
+  template <class F>
+  void forEach(F f) const
+  {
+    for (size_t i = 0; i < dense.size(); i++)
+      if (used[i]) f(base + i, dense[i]);
+    for (typename Table::const_iterator it = table.begin(); it != table.end(); ++it)
+      f(it->first, it->second);
+  }
+
+private:
+  typedef CkFlatHashMap<CmiUInt8, V> Table;
+
+  // The window may have this many empty slots beyond one per entry
+  enum { DENSE_SLACK = 64 };
+
+  Table table;
+  std::vector<V> dense;
+  std::vector<uint8_t> used;
+  CmiUInt8 base;  // ID of dense[0]
+  size_t denseCount;
+  bool denseOK;
+
+  // Grow the window to cover id, unless it would end up less than half full
+  bool widen(CmiUInt8 id)
+  {
+    if (denseCount == 0)
+    {
+      dense.assign(1, V());
+      used.assign(1, 0);
+      base = id;
+      return true;
+    }
+    CmiUInt8 limit = 2 * (denseCount + 1) + DENSE_SLACK;
+    CmiUInt8 lo = std::min(base, id);
+    CmiUInt8 hi = std::max<CmiUInt8>(base + dense.size(), id + 1);
+    if (hi - lo > limit) return false;
+    if (lo < base)
+    {
+      // Leave room below, so that descending IDs do not shift the window each time
+      CmiUInt8 extra = std::min<CmiUInt8>(std::min<CmiUInt8>(limit - (hi - lo), lo), dense.size());
+      lo -= extra;
+      dense.insert(dense.begin(), base - lo, V());
+      used.insert(used.begin(), base - lo, 0);
+      base = lo;
+    }
+    if (hi - base > dense.size())
+    {
+      dense.resize(hi - base, V());
+      used.resize(hi - base, 0);
+    }
+    return true;
+  }
+};
+
+#endif
@@ -10,6 +10,8 @@ array proxies, or the details of element creation (see ckarray.h).
 #define __CKLOCATION_H
 
 #include <unordered_map>
+#include "ckflathash.h"
+
 struct IndexHasher
 {
 public:
@@ -322,7 +324,7 @@ class CkLocCache : public CBase_CkLocCache
 {
 private:
   // Map of ID to PE
-  using LocationMap = std::unordered_map<CmiUInt8, CkLocEntry>;
+  using LocationMap = CkFlatHashMap<CmiUInt8, CkLocEntry>;
   LocationMap locMap;
 
   using Listener = std::function<void(CmiUInt8, int)>;
@@ -382,12 +384,12 @@ private:
   friend class MemElementPacker;
 
   using ArrayIdMap = std::unordered_map<CkArrayID, CkArray*, ArrayIDHasher>;
-  using MsgBuffer = std::unordered_map<CmiUInt8, std::vector<CkArrayMessage*> >;
+  using MsgBuffer = CkFlatHashMap<CmiUInt8, std::vector<CkArrayMessage*> >;
   using LocationRequestBuffer =
       std::unordered_map<CkArrayIndex, std::vector<int>, IndexHasher>;
-  using IdxIdMap = std::unordered_map<CkArrayIndex, CmiUInt8, IndexHasher>;
-  using LocRecHash = std::unordered_map<CmiUInt8, CkLocRec*>;
-  using ElemMap = std::unordered_map<CmiUInt8, CkMigratable*>;
+  using IdxIdMap = CkFlatHashMap<CkArrayIndex, CmiUInt8, IndexHasher>;
+  using LocRecHash = CkElementIdMap<CkLocRec*>;
+  using ElemMap = CkFlatHashMap<CmiUInt8, CkMigratable*>;
 
   using LocationListener = std::function<void(CmiUInt8, int)>;
   using IndexListener = std::function<void(const CkArrayIndex&, CmiUInt8, int)>;
@@ -604,6 +606,10 @@ public:
     }
   }
 
+  // The IDs of a 1D array are its indices (plus the home PE), so a block
+  // map gives each PE a run of consecutive IDs
+  bool hasDenseIDs() const { return compressor && bounds.dimension == 1; }
+
   int getMapHandle() const { return mapHandle; }
   CkGroupID getMap() const { return mapID; }
 
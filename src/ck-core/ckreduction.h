@@ -18,6 +18,9 @@ The calls needed to use the reduction manager are:
 #ifndef _CKREDUCTION_H
 #define _CKREDUCTION_H
 
+#include <algorithm>
+#include <vector>
+
 #include "CkReduction.decl.h"
 
 #ifdef _PIPELINED_ALLREDUCE_
@@ -25,6 +28,25 @@ The calls needed to use the reduction manager are:
 #define FRAG_THRESHOLD 131072
 #endif
 
+/* Reduction trees combine the PEs of a node directly at its first PE,
+   and connect the nodes with a topology-aware tree of this many children
+   per node (set with +reductionTreeArity) */
+#define CK_REDUCTION_TREE_ARITY 4
+extern int _reductionTreeArity;
+extern CmiSpanningTreeInfo *_reductionTree; // this node's place in that tree
+
+/* With +reductionSegmentSize, contributions that ask for it with
+   CkReductionMsg::setSegmented and are larger than this many bytes are
+   split into segments, if they use an element-wise built-in reducer (sum
+   through bitvec_xor). Each segment is reduced as a reduction of its own,
+   so the segments climb the tree one behind the other, and the root joins
+   them before calling the client. A contribution is split into at most
+   CK_REDUCTION_MAX_SEGMENTS segments (CkReductionMsg::nFrags is 8 bits).
+   Since each segment uses up a reduction number, every contribution to a
+   segmented reduction must ask for segments and have the same size. */
+#define CK_REDUCTION_MAX_SEGMENTS 127
+extern int _reductionSegmentSize;
+
 
 //This message is sent between group objects on a single PE
 // to let each know the other has been created.
@@ -392,6 +414,10 @@ public:
 	inline bool isMigratableContributor() const {return migratableContributor;}
 	inline void setMigratableContributor(bool _mig){ migratableContributor = _mig;}
 
+	//Reduce this contribution in segments (see +reductionSegmentSize). Every
+	// contribution to the reduction must ask for this and have the same size.
+	inline void setSegmented(bool s=true) { segmented=s; }
+
     // Tuple reduction
     static CkReductionMsg* buildFromTuple(CkReduction::tupleElement* reductions, int num_reductions);
     void toTuple(CkReduction::tupleElement** out_reductions, int* num_reductions);
@@ -407,8 +433,12 @@ public:
 private:
 	inline int nSources() const {return std::abs(sourceFlag);}
 
+	inline bool isSegmentable() const {
+		return segmented && reducer>=CkReduction::sum_char && reducer<=CkReduction::bitvec_xor_bool;
+	}
+
 	//Default constructor is private so you must use "buildNew", above
-	CkReductionMsg() {}
+	CkReductionMsg() : segmented(false), rebuilt(0), nFrags(1), fragNo(0) {}
 
 private:
 	int dataSize;//Length of array below, in bytes
@@ -426,10 +456,12 @@ private:
 	CkReduction::reducerType reducer;
 	CMK_REFNUM_TYPE userFlag; //Some sort of identifying flag, for client use
 	bool migratableContributor; // are the contributors migratable
+	bool segmented; // the contributor asked for a segmented reduction
         // for section multicast/reduction library
         int8_t rebuilt;          // indicate if the multicast tree needs rebuilt
         int8_t nFrags;
-        int8_t fragNo;      // fragment of a reduction msg (when pipelined)
+        int8_t fragNo;      // fragment of a reduction msg (when pipelined),
+                         // or segment of a segmented reduction
                          // value = 0 to nFrags-1
         CkSectionInfo sid;   // section cookie for multicast
 	CkCallback callback; //What to do when done
@@ -437,6 +469,101 @@ private:
 	double dataStorage;//Start of data array (so it's double-aligned)
 };
 
+/*
+Keyed reductions: each contribution is an array of records sorted by
+key.  The reducer merges its nMsg inputs with a k-way merge and combines
+the records whose keys are equal, so every level of the reduction tree
+passes on at most one record per distinct key.
+
+CkMergeSortedRecords is the merge itself; "less" orders two records by
+key, and "combine(into,from)" folds the value of "from" into "into".
+*/
+template <class Rec, class Less, class Combine>
+CkReductionMsg *CkMergeSortedRecords(int nMsg, CkReductionMsg **msg,
+                                     Less less, Combine combine)
+{
+  struct cursor { const Rec *cur, *end; };
+  std::vector<cursor> heap;
+  heap.reserve(nMsg);
+  size_t total = 0;
+  for (int i = 0; i < nMsg; i++) {
+    const Rec *r = (const Rec *)msg[i]->getData();
+    size_t n = msg[i]->getSize() / sizeof(Rec);
+    total += n;
+    if (n > 0) heap.push_back({r, r + n});
+  }
+
+  // Min-heap on the next record of each input
+  auto later = [&less](const cursor &a, const cursor &b) { return less(*b.cur, *a.cur); };
+  std::make_heap(heap.begin(), heap.end(), later);
+
+  std::vector<Rec> out;
+  out.reserve(total);
+  while (!heap.empty()) {
+    std::pop_heap(heap.begin(), heap.end(), later);
+    cursor &c = heap.back();
+    if (!out.empty() && !less(out.back(), *c.cur))
+      combine(out.back(), *c.cur);
+    else
+      out.push_back(*c.cur);
+    if (++c.cur != c.end)
+      std::push_heap(heap.begin(), heap.end(), later);
+    else
+      heap.pop_back();
+  }
+  return CkReductionMsg::buildNew(out.size() * sizeof(Rec), out.data());
+}
+
+/*
+A keyed reduction over CkKeyedRecord<K,V>, whose values are combined
+with Op (e.g. std::plus<double>).  K needs operator<, and both K and V
+must be bitwise copyable.  Register the reducer once on every node,
+from an initnode routine:
+   sumByKey = CkKeyedReducer<int, double, std::plus<double> >::registerReducer();
+and contribute a vector of records that went through sortAndCombine:
+   CkKeyedReducer<int, double, std::plus<double> >::sortAndCombine(recs);
+   contribute(recs, sumByKey, cb);
+The result is a sorted array of CkKeyedRecord<K,V>, one per distinct key.
+*/
+template <class K, class V>
+struct CkKeyedRecord {
+  K key;
+  V value;
+};
+
+template <class K, class V, class Op>
+class CkKeyedReducer {
+public:
+  typedef CkKeyedRecord<K,V> record;
+
+  static bool less(const record &a, const record &b) { return a.key < b.key; }
+  static void combine(record &into, const record &from) {
+    into.value = Op()(into.value, from.value);
+  }
+
+  static CkReductionMsg *reduce(int nMsg, CkReductionMsg **msg) {
+    return CkMergeSortedRecords<record>(nMsg, msg, less, combine);
+  }
+
+  // Streaming merges each contribution into the partial result as it
+  // arrives, which costs a pass over that result per contribution; it
+  // only pays off when contributions share most of their keys.
+  static CkReduction::reducerType registerReducer(bool streamable=false) {
+    return CkReduction::addReducer(reduce, streamable, "CkKeyedReducer");
+  }
+
+  // Sort a local contribution by key, combining repeated keys
+  static void sortAndCombine(std::vector<record> &recs) {
+    std::stable_sort(recs.begin(), recs.end(), less);
+    size_t n = 0;
+    for (size_t i = 0; i < recs.size(); i++) {
+      if (n > 0 && !less(recs[n-1], recs[i])) combine(recs[n-1], recs[i]);
+      else recs[n++] = recs[i];
+    }
+    recs.resize(n);
+  }
+};
+
 
 #define CK_REDUCTION_CONTRIBUTE_METHODS_DECL \
   void contribute(int dataSize,const void *data,CkReduction::reducerType type, \
@@ -544,7 +671,6 @@ private:
 
 	void init_TopoTree();
 	void init_BinaryTree();
-	enum {TREE_WID=2};
 	int treeRoot(void);//Root PE
 	bool hasParent(void);
 	int treeParent(void);//My parent PE
@@ -628,6 +754,8 @@ public:
 // field of the message must be valid.
 // Each contributor must contribute exactly once to each reduction.
 	void contribute(contributorInfo *ci,CkReductionMsg *msg);
+	//Contribute a large msg as several segmented reductions
+	void contributeSegments(contributorInfo *ci,CkReductionMsg *msg);
 
 //Communication (library-private)
 	//Sent down the reduction tree (used by barren PEs)
@@ -667,6 +795,9 @@ private:
 //Data members
 	//Stored callback function (may be NULL if none has been set)
 	CkCallback storedCallback;
+	//Root only: the segments of a segmented reduction received so far
+	CkReductionMsg *segmentJoin;
+	CkReductionMsg *joinSegment(CkReductionMsg *m);
 
 	int redNo;//Number of current reduction (incremented at end) to be deposited with NodeGroups
 	int completedRedNo;//Number of reduction Completed ie recieved callback from NodeGroups
@@ -720,7 +851,6 @@ private:
 
 	void init_TopoTree();
 	void init_BinaryTree();
-	enum {TREE_WID=2};
 	int treeRoot(void);//Root PE
 
 	//Map reduction number to a time
@@ -24,6 +24,32 @@ void  CmiPoolAllocStats(void);
 
 /* theoretically we should put a pool cleanup function in here */
 
+/* Size-class pool for CmiAlloc message buffers (+CmiMsgPool).
+   Each PE keeps its own free lists; blocks freed on another PE, or on the
+   communication thread, go back to their owner through a lock-free return
+   list. Requests larger than the biggest class, and every request when the
+   pool is off, fall through to malloc. */
+#define CMI_MSGPOOL_NUM_CLASSES 6
+#define CMI_MSGPOOL_MIN_BYTES 64 /* the largest class holds 64 << 5 = 2048 bytes */
+
+typedef struct {
+  CmiInt8 allocs;          /* CmiMsgPoolAlloc calls on this PE */
+  CmiInt8 pooledAllocs;    /* ...served from a size class */
+  CmiInt8 remoteFrees;     /* blocks handed back by other PEs */
+  CmiInt8 slabBytes;       /* memory obtained from malloc for slabs */
+  CmiInt8 bytesInUse;      /* pooled bytes currently allocated */
+  CmiInt8 bytesHighWater;  /* largest value bytesInUse has reached */
+  CmiInt8 inUse[CMI_MSGPOOL_NUM_CLASSES];     /* blocks not back on a free list, per class */
+  CmiInt8 highWater[CMI_MSGPOOL_NUM_CLASSES]; /* largest inUse, per class */
+} CmiMsgPoolStats;
+
+void  CmiMsgPoolInit(char **argv);
+void *CmiMsgPoolAlloc(int numBytes);
+void  CmiMsgPoolFree(void *p);
+/* Returns 0 if this PE has no pool */
+int   CmiMsgPoolGetStats(CmiMsgPoolStats *stats);
+void  CmiMsgPoolPrintStats(void);
+
 #if defined(__cplusplus)
 }
 #endif
@@ -73,10 +73,22 @@ void CmiIpcInit(char** argv);
 // ( this must be called in the same order on all pes! )
 CmiIpcManager* CmiMakeIpcManager(CthThread th);
 
+// creates a manager for processes [firstProc, firstProc + nProcs), which
+// the caller knows to share this host, giving each segment one ring per
+// sender; no messages are exchanged, so machine layers may call it during
+// startup ( each process of the group calls it with the same arguments,
+// tag must be unique to the job; returns null where unsupported )
+CmiIpcManager* CmiMakeIpcManager(int firstProc, int nProcs, std::size_t tag);
+
 // push/pop blocks from the manager's send/recv queue
 bool CmiPushIpcBlock(CmiIpcManager*, CmiIpcBlock*);
 CmiIpcBlock* CmiPopIpcBlock(CmiIpcManager*);
 
+// push/pop blocks from the per-sender rings of a group manager, preserving
+// the order of each sender's blocks; push fails when the ring is full
+bool CmiPushIpcRing(CmiIpcManager*, CmiIpcBlock*);
+CmiIpcBlock* CmiPopIpcRing(CmiIpcManager*);
+
 // tries to allocate a block, returning null if unsucessful
 // (fails when other PEs are contending resources)
 // second value of pair indicates failure cause
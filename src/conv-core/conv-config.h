@@ -123,6 +123,11 @@
 #define CMK_CUDA                  0
 #endif
 
+/* Set by LRTS machine layers that implement LrtsSendVectorFunc */
+#if !defined(CMK_LRTS_VECTOR_SEND)
+#define CMK_LRTS_VECTOR_SEND      0
+#endif
+
 #ifndef CMI_QD
 #define CMI_QD (CMK_REPLAYSYSTEM)
 #endif
@@ -180,3 +185,9 @@ typedef CMK_TYPEDEF_UINT4     CmiIntPtr;
 
 /* Enable node queue for all SMP and multicore builds */
 #define CMK_NODE_QUEUE_AVAILABLE CMK_SMP
+
+/* Allocate each rank's Cpv variables from cache-line-aligned blocks owned
+   by its own thread (see CmiCpvAlloc) instead of from the shared heap */
+#ifndef CMK_CPV_BLOCKS
+#define CMK_CPV_BLOCKS (CMK_SMP && CMK_HAS_TLS_VARIABLES)
+#endif
@@ -3,18 +3,25 @@
 #include "converse.h"
 #include "taskqueue.h"
 
+/* Maximum number of tasks taken from a victim in one StealTask() */
+#define TASKQ_STEAL_BATCH_MAX 64
+
 #if CMK_TRACE_ENABLED
 #include "conv-trace.h"
 #define TASKQ_CREATE_EVENTID 145
 #define TASKQ_WORK_EVENTID 147
 #define TASKQ_STEAL_EVENTID 149
 #define TASKQ_QUEUE_STEAL_EVENTID 151
+/* user stats, one attempt/failure pair per locality tier */
+#define TASKQ_STEAL_ATTEMPT_STATID 153
+#define TASKQ_STEAL_FAILURE_STATID 154
 #endif
 #ifdef __cplusplus
 extern "C" {
 #endif
 void StealTask();
-void CmiTaskQueueInit();
+void CmiTaskQueueInit(char **argv);
+void CmiTaskQueuePublishLocality();
 #ifdef __cplusplus
 }
 #endif
@@ -77,6 +77,9 @@
 #define CMI_IS_ZC_DEVICE(msg)                (CMI_ZC_MSGTYPE(msg) == CMK_ZC_DEVICE_MSG)
 
 #define CMI_MSG_NOKEEP(msg)                  ((CmiMsgHeaderBasic *)msg)->nokeep
+/* Set by the sender of a large message of floating point data to have
+   the machine layer compress it on the network (see +compressThreshold) */
+#define CMI_MSG_COMPRESS(msg)                ((CmiMsgHeaderBasic *)msg)->compress
 
 #define CmiIsPow2OrZero(v) (((v) & ((v) - 1)) == 0)
 #define CmiIsPow2(v) (CmiIsPow2OrZero(v) && (v))
@@ -246,13 +249,26 @@ void setMemoryOwnedBy(void *p, int id);
  *
  *****************************************************************************/
 
+#if CMK_CPV_BLOCKS
+/* Zeroed storage from the calling thread's Cpv blocks; never freed */
+void *CmiCpvAlloc(size_t size, size_t align);
+#endif
+
 #ifdef __cplusplus
 /* In C++, use new so t's constructor gets called */
 # define CpvInit_Alloc(t,n) new t[n]()
-# define CpvInit_Alloc_scalar(t) new t()
+# if CMK_CPV_BLOCKS
+#  define CpvInit_Alloc_scalar(t) new (CmiCpvAlloc(sizeof(t), alignof(t))) t()
+# else
+#  define CpvInit_Alloc_scalar(t) new t()
+# endif
 #else
 # define CpvInit_Alloc(t,n) (t *)calloc(n,sizeof(t))
-# define CpvInit_Alloc_scalar(t) (t *)calloc(1,sizeof(t))
+# if CMK_CPV_BLOCKS
+#  define CpvInit_Alloc_scalar(t) (t *)CmiCpvAlloc(sizeof(t), 2*sizeof(double))
+# else
+#  define CpvInit_Alloc_scalar(t) (t *)calloc(1,sizeof(t))
+# endif
 #endif
 
 extern int CmiMyRank_(void);
@@ -421,6 +437,8 @@ extern int _Cmi_mynode;
 extern int _Cmi_numnodes;
 extern int _Cmi_sleepOnIdle;
 extern int _Cmi_forceSpinOnIdle;
+extern int _Cmi_blockOnIdle;
+extern int _Cmi_idleSpinUs;
 
 int CmiMyPe(void);
 int CmiMyRank(void);
@@ -465,6 +483,11 @@ extern CmiNodeLock CmiCreateLock(void);
 extern void CmiDestroyLock(CmiNodeLock lock);
 #endif // CMK_USE_LRTS
 
+#if CMK_USE_LRTS && CMK_NODE_QUEUE_AVAILABLE
+/*Wake a rank blocked with +CmiBlockOnIdle to take a node-level message*/
+extern void CmiWakeNodeSleeper(void);
+#endif
+
 extern CmiNodeLock CmiMemLock_lock;
 #define CmiMemLock() do{if (CmiMemLock_lock) CmiLock(CmiMemLock_lock);} while (0)
 
@@ -502,6 +525,8 @@ extern int _Cmi_mynode;
 extern int _Cmi_numnodes;
 extern int _Cmi_sleepOnIdle;
 extern int _Cmi_forceSpinOnIdle;
+extern int _Cmi_blockOnIdle;
+extern int _Cmi_idleSpinUs;
 
 int CmiMyPe(void);
 int CmiMyRank(void);
@@ -615,6 +640,33 @@ for each processor in the node.
 #define CpvAccessOther(v, r) (*(CMK_TAG(Cpv_addr_,v)[r]))
 #else
 
+#if CMK_CPV_BLOCKS
+/* Rank 0 creates the array of per-rank pointers, and every rank then
+   allocates its own value so that ranks never share a cache line */
+#define CpvDeclare(t,v) t** CMK_TAG(Cpv_,v)
+#define CpvExtern(t,v)  extern t** CMK_TAG(Cpv_,v)
+#ifdef __cplusplus
+#define CpvCExtern(t,v)    extern "C" t** CMK_TAG(Cpv_,v)
+#else
+#define CpvCExtern(t,v)    CpvExtern(t,v)
+#endif
+#define CpvStaticDeclare(t,v) static t** CMK_TAG(Cpv_,v)
+#define CpvInitialize(t,v)\
+    do { \
+       if (CmiMyRank()) { \
+               CmiMemoryReadFence(); \
+		       while (0==CMK_TAG(Cpv_,v)) { CMK_CPV_IS_SMP ; CmiMemoryReadFence(); } \
+       } else if (0==CMK_TAG(Cpv_,v)) { \
+               t** tmp = CpvInit_Alloc(t*,1+CmiMyNodeSize());\
+               CmiMemoryWriteFence();   \
+               CMK_TAG(Cpv_,v)=tmp;   \
+       } \
+       CMK_TAG(Cpv_,v)[CmiMyRank()] = CpvInit_Alloc_scalar(t); \
+    } while(0)
+#define CpvInitialized(v) (0!=CMK_TAG(Cpv_,v) && 0!=CMK_TAG(Cpv_,v)[CmiMyRank()])
+#define CpvAccess(v) (*CMK_TAG(Cpv_,v)[CmiMyRank()])
+#define CpvAccessOther(v, r) (*CMK_TAG(Cpv_,v)[r])
+#else
 #define CpvDeclare(t,v) t* CMK_TAG(Cpv_,v)
 #define CpvExtern(t,v)  extern t* CMK_TAG(Cpv_,v)
 #ifdef __cplusplus
@@ -639,6 +691,7 @@ for each processor in the node.
 #define CpvAccess(v) CMK_TAG(Cpv_,v)[CmiMyRank()]
 #define CpvAccessOther(v, r) CMK_TAG(Cpv_,v)[r]
 #endif
+#endif
 
 #endif
 
@@ -686,6 +739,7 @@ typedef struct
 extern CmiHwlocTopology CmiHwlocTopologyLocal;
 
 extern void CmiInitHwlocTopology(void);
+extern void CmiGetPuLocality(int *coreComplex, int *socket);
 
 /** Return 1 if our outgoing message queue 
    for this node is longer than this many bytes. */
@@ -720,6 +774,7 @@ CsvExtern(CmiNodeLock, CsdNodeQueueLock);
 CpvExtern(int,         CsdStopFlag);
 CpvExtern(int,         CsdLocalCount);
 #define CSD_LOCAL_MAX_DEFAULT 0
+#define CSD_SCHED_BATCH_DEFAULT 1
 
 extern void CmiAssignOnce(int* variable, int value);
 
@@ -888,6 +943,8 @@ int      CmiSize(void *blk);
 void     CmiFree(void *blk);
 void     CmiRdmaFree(void *blk);
 void     CmiInitMsgHeader(void *msg, int size);
+/* Sizes of the messages this PE compressed, and of their compressed form */
+void     CmiGetCompressStats(CmiUInt8 *rawBytes, CmiUInt8 *wireBytes);
 
 #ifndef CMI_TMP_SKIP
 void *CmiTmpAlloc(int size);
@@ -993,29 +1050,16 @@ char *CmiPrintDate(void);
 
 #if CMK_NODE_QUEUE_AVAILABLE
 
-#define CsdNodeEnqueueGeneral(x,s,i,p) do { \
-          CmiLock(CsvAccess(CsdNodeQueueLock));\
-          CqsEnqueueGeneral((Queue)CsvAccess(CsdNodeQueue),(x),(s),(i),(p)); \
-          CmiUnlock(CsvAccess(CsdNodeQueueLock)); \
-        } while(0)
-#define CsdNodeEnqueueFifo(x)     do { \
-          CmiLock(CsvAccess(CsdNodeQueueLock));\
-          CqsEnqueueFifo((Queue)CsvAccess(CsdNodeQueue),(x)); \
-          CmiUnlock(CsvAccess(CsdNodeQueueLock)); \
-        } while(0)
-#define CsdNodeEnqueueLifo(x)     do { \
-          CmiLock(CsvAccess(CsdNodeQueueLock));\
-          CqsEnqueueLifo((Queue)CsvAccess(CsdNodeQueue),(x))); \
-          CmiUnlock(CsvAccess(CsdNodeQueueLock)); \
-        } while(0)
-#define CsdNodeEnqueue(x)     do { \
-          CmiLock(CsvAccess(CsdNodeQueueLock));\
-          CqsEnqueueFifo((Queue)CsvAccess(CsdNodeQueue),(x));\
-          CmiUnlock(CsvAccess(CsdNodeQueueLock)); \
-        } while(0)
+extern void CsdNodeQueueEnqueue(void *msg, int strategy, int priobits, unsigned int *prioptr);
+extern int  CsdNodeQueueLength(void);
+
+#define CsdNodeEnqueueGeneral(x,s,i,p) CsdNodeQueueEnqueue((x),(s),(i),(p))
+#define CsdNodeEnqueueFifo(x)     CsdNodeQueueEnqueue((x),CQS_QUEUEING_FIFO,0,NULL)
+#define CsdNodeEnqueueLifo(x)     CsdNodeQueueEnqueue((x),CQS_QUEUEING_LIFO,0,NULL)
+#define CsdNodeEnqueue(x)         CsdNodeQueueEnqueue((x),CQS_QUEUEING_FIFO,0,NULL)
 
-#define CsdNodeEmpty()            (CqsEmpty(C(Queue)pvAccess(CsdNodeQueue)))
-#define CsdNodeLength()           (CqsLength((Queue)CpvAccess(CsdNodeQueue)))
+#define CsdNodeEmpty()            (CsdNodeQueueLength() == 0)
+#define CsdNodeLength()           (CsdNodeQueueLength())
 
 #else
 
@@ -1141,6 +1185,50 @@ extern void  CsdEndIdle(void);
 extern void  CsdStillIdle(void);
 extern void  CsdBeginIdle(void);
 
+/* Scheduler statistics: cheap per-PE counters, kept unless the runtime is
+   built with CSD_NO_SCHED_STATS. Read them with CsdGetSchedStats, or from
+   outside the job with the "converse/sched_stats" CCS handler. */
+
+/* Where CsdNextMessage found a message */
+enum {
+  CSD_SRC_LOCAL = 0,    /* onnode FIFO of this PE */
+  CSD_SRC_NETWORK,      /* offnode queue of this PE */
+  CSD_SRC_SCHED,        /* scheduler priority queue */
+  CSD_SRC_NODE_NETWORK, /* offnode queue of this node */
+  CSD_SRC_NODE,         /* node priority queue */
+  CSD_SRC_TASK,         /* task queue */
+  CSD_SRC_OTHER,        /* grid and object queues */
+  CSD_NUM_SRCS
+};
+
+/* Queue lengths are sampled every CSD_DEPTH_SAMPLE_PERIOD dispatched
+   messages into log2 buckets: bucket 0 counts empty queues, bucket b > 0
+   lengths in [2^(b-1), 2^b), and the last bucket everything longer. */
+#define CSD_DEPTH_SAMPLE_PERIOD 64
+#define CSD_DEPTH_BUCKETS 16
+
+typedef struct {
+  CmiUInt8 dispatched[CSD_NUM_SRCS];
+  CmiUInt8 schedQDepth[CSD_DEPTH_BUCKETS];
+  CmiUInt8 localQDepth[CSD_DEPTH_BUCKETS];
+  CmiUInt8 idleBegin;        /* busy to idle transitions */
+  CmiUInt8 idleEnd;          /* idle to busy transitions */
+  CmiUInt8 nodeQLockBusy;    /* node queue trylocks that found the lock taken */
+  CmiUInt8 stealAttempts;    /* task queue steal attempts */
+  CmiUInt8 stealFailures;    /* ... that came back empty */
+} CsdSchedStats;
+
+CpvExtern(CsdSchedStats, CsdStats);
+#if CSD_NO_SCHED_STATS
+#define CsdCountStat(field)
+#else
+#define CsdCountStat(field) (CpvAccess(CsdStats).field++)
+#endif
+
+/* Copy this PE's counters into stats */
+extern void CsdGetSchedStats(CsdSchedStats *stats);
+extern void CsdResetSchedStats(void);
+
 typedef struct {
   void *localQ;
   Queue nodeQ;
@@ -1157,12 +1245,14 @@ typedef struct {
   Queue taskQ;
   void *suspendedTaskQ;
 #endif
+  CsdSchedStats *stats;
 } CsdSchedulerState_t;
 extern void CsdSchedulerState_new(CsdSchedulerState_t *state);
 extern void *CsdNextMessage(CsdSchedulerState_t *state);
 extern void *CsdNextLocalNodeMessage(CsdSchedulerState_t *state);
 
 extern void  *CmiGetNonLocal(void);
+extern int    CmiGetNonLocalBatch(void **msgs, int max);
 extern void   CmiNotifyIdle(void);
 
 /*Different kinds of schedulers: generic, eternal, counting, polling*/
@@ -2009,6 +2099,10 @@ void CommunicationServerPxshm(void);
 */
 #if CMK_IMMEDIATE_MSG
 void CmiDelayImmediate(void);
+/* Per-handler histogram of how long immediate messages waited (with
+   +immCommThread); see immediate.C */
+#define CMI_IMM_LATENCY_BUCKETS 24
+CmiUInt8 CmiGetImmediateLatency(int handler, CmiUInt8 *counts, double *maxWait);
 #  define CmiBecomeImmediate(msg) do { \
 	CmiSetHandler(msg, (CmiGetHandler(msg))|0x8000); \
      } while (0)
@@ -11,7 +11,7 @@
     @{
  */
 
-#include "conv-config.h"
+#include "conv-header.h" /* for CmiUInt8 */
 
 #ifdef __cplusplus
 extern "C" {
@@ -114,6 +114,51 @@ typedef struct prioq1_struct
 #endif
 */
 
+/**
+   A bucket of an intprioq_struct: one integer key and the deque of
+   entries enqueued with it.
+*/
+typedef struct intprioqelt_struct
+{
+  struct deq_struct data;
+  CmiUInt8 key;
+  struct intprioqelt_struct *next_free; /**< Link in the free list of recycled buckets */
+}
+*_intprioqelt;
+
+/** A heap slot of an intprioq_struct, so that sifting never dereferences a bucket */
+typedef struct intprioqslot_struct
+{
+  CmiUInt8 key;
+  _intprioqelt elt;
+}
+*_intprioqslot;
+
+/**
+   A priority queue specialized for fixed-width integer priorities: a
+   binary heap of the distinct keys, compared as plain integers, and an
+   open-addressing (linear probing) hash table from key to bucket.
+
+   Keys are the biased priorities used by the general queue (the
+   priority plus 2^(bits-1)), so their unsigned order is the order of
+   the equivalent variable bit length priorities.
+*/
+typedef struct intprioq_struct
+{
+  unsigned int bits; /**< CINTBITS or CLONGBITS; 0 until the first priority is enqueued */
+  int heapsize;
+  int heapnext;
+  _intprioqslot heap; /**< Heap of (key, bucket), 1-based */
+  _intprioqelt *hashtab;
+  unsigned int hashmask; /**< Hash table size - 1, the size is a power of 2 */
+  unsigned int hashshift; /**< 64 - log2(hash table size) */
+  int hash_entry_size;
+  _intprioqelt last; /**< Bucket of the most recent enqueue, checked before hashing */
+  _intprioqelt freelist;
+  _prio toppri; /**< Highest priority as a prio_struct (room for 2 ints), for CqsGetPriority */
+}
+*_intprioq;
+
 /*#ifndef FASTQ*/
 /**
    A set of 3 queues: a positive priority prioq_struct, a negative
@@ -121,6 +166,13 @@ typedef struct prioq1_struct
    
    If the user modifies the queue, NULL entries may be present, and
    hence NULL values will be returned by CqsDequeue().
+
+   As long as every prioritized entry uses the same fixed-width integer
+   strategy (CQS_QUEUEING_I* or CQS_QUEUEING_L*), those entries are kept
+   in intprioq instead of negprioq/posprioq. The first bit vector
+   priority, or an integer of the other width while intprioq is not
+   empty, moves them into the general queues for good (see
+   CqsUseGeneralPrioq).
 */
 typedef struct Queue_struct
 {
@@ -132,6 +184,8 @@ typedef struct Queue_struct
   struct deq_struct zeroprio; /**< A double ended queue for zero priority messages */
   struct prioq_struct negprioq; /**< A priority queue for negative priority messages */
   struct prioq_struct posprioq; /**< A priority queue for negative priority messages */
+  struct intprioq_struct intprioq; /**< Fixed-width integer priorities, while usable */
+  int generalprio; /**< Set once intprioq has been given up on */
 #endif
 }
 *Queue;
@@ -209,6 +263,14 @@ void CqsIncreasePriorityForEntryMethod(Queue q, const int entrymethod);
 */
 void CqsRemoveSpecific(Queue, const void *msgPtr);
 
+/**
+   Move any entries held by the integer priority queue into the general
+   priority queues, and keep using those from now on. Needed before
+   inspecting negprioq/posprioq directly. Only the first call does any
+   work.
+*/
+void CqsUseGeneralPrioq(Queue q);
+
 #ifdef ADAPT_SCHED_MEM
 void CqsIncreasePriorityForMemCriticalEntries(Queue q);
 #endif
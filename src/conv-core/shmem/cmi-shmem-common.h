@@ -52,6 +52,17 @@ struct ipc_shared_ {
   }
 };
 
+// number of blocks each per-sender ring can hold
+constexpr std::size_t kRingSlots = 256;
+
+// single-producer/single-consumer queue of block offsets,
+// owned by the receiver and fed by exactly one sender
+struct ipc_ring_ {
+  alignas(CMI_CACHE_LINE_SIZE) std::atomic<std::uint32_t> head;
+  alignas(CMI_CACHE_LINE_SIZE) std::atomic<std::uint32_t> tail;
+  alignas(CMI_CACHE_LINE_SIZE) std::uintptr_t slots[kRingSlots];
+};
+
 // shared data for each pe
 struct ipc_metadata_ {
   // maps ranks to shared segments
@@ -60,17 +71,53 @@ struct ipc_metadata_ {
   int mine;
   // key of this instance
   std::size_t key;
+  // first process of the group and number of rings per segment
+  // (only managers made for a known group of processes have rings)
+  int firstProc;
+  int nRings;
+  // ring to look at first on the next pop
+  int nextRing;
   // base constructor
-  ipc_metadata_(std::size_t key_) : mine(CmiMyNode()), key(key_) {}
+  ipc_metadata_(std::size_t key_)
+      : mine(CmiMyNode()), key(key_), firstProc(0), nRings(0), nextRing(0) {}
   // virtual destructor may be needed
   virtual ~ipc_metadata_() {}
 };
 
 inline std::size_t whichBin_(std::size_t size);
 
-inline static void initIpcShared_(ipc_shared_* shared) {
-  auto begin = (std::uintptr_t)(sizeof(ipc_shared_) +
-                                (sizeof(ipc_shared_) % ALIGN_BYTES));
+// the rings (if any) sit between the header and the heap of a segment
+inline static std::uintptr_t ringsBegin_(void) {
+  constexpr auto align = alignof(ipc_ring_);
+  return (sizeof(ipc_shared_) + align - 1) / align * align;
+}
+
+inline static std::uintptr_t heapBegin_(int nRings) {
+  if (nRings == 0) {
+    return (std::uintptr_t)(sizeof(ipc_shared_) +
+                            (sizeof(ipc_shared_) % ALIGN_BYTES));
+  } else {
+    return ringsBegin_() + nRings * sizeof(ipc_ring_);
+  }
+}
+
+inline static std::size_t segmentSize_(int nRings) {
+  if (nRings == 0) {
+    return CpvAccess(kSegmentSize) + sizeof(ipc_shared_);
+  } else {
+    return heapBegin_(nRings) + CpvAccess(kSegmentSize);
+  }
+}
+
+inline static ipc_ring_* ringOf_(ipc_shared_* shared, int sender) {
+  return (ipc_ring_*)((char*)shared + ringsBegin_()) + sender;
+}
+
+// initializes the header of a segment, leaving its rings alone
+// ( they start out zeroed, i.e., empty, and senders may use them
+//   before the owner of the segment gets here )
+inline static void initIpcShared_(ipc_shared_* shared, int nRings = 0) {
+  auto begin = heapBegin_(nRings);
   CmiAssert(begin != cmi::ipc::nil);
   auto end = begin + CpvAccess(kSegmentSize);
   new (shared) ipc_shared_(begin, end);
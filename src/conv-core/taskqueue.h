@@ -1,80 +1,149 @@
 #ifndef _CKTASKQUEUE_H
 #define _CKTASKQUEUE_H
-#define TaskQueueSize 1024
+
+#include "conv-config.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+
+// Initial number of slots; the deque doubles its buffer whenever it fills up.
+#define TaskQueueInitSize 1024
 //Uncomment for debug print statements
 #define TaskQueueDebug(...) //CmiPrintf(__VA_ARGS__)
-// This taskqueue implementation refers to the work-stealing queue of Cilk (THE protocol).
+// This taskqueue implementation is the dynamically resizable Chase-Lev
+// work-stealing deque, using the C11/C++11 memory orderings of
+// Le et al., "Correct and Efficient Work-Stealing for Weak Memory Models" (PPoPP'13).
 // New tasks are pushed into the tail of this queue and the tasks are popped at the tail of this queue by the same thread. Thieves(other threads trying to steal) steal a task at the head of this queue.
 // So, synchronization is needed only when there is only one task in the queue because thieves and victim can try to obtain the same task.
-#ifdef _WIN32
-#define WIN32_LEAN_AND_MEAN
-#include <windows.h>
-typedef LONG taskq_idx;
-#else
-typedef int taskq_idx;
-#endif
+// When the owner runs out of slots, it copies the live tasks into a buffer twice as large. Thieves may still be
+// reading the old buffer, so retired buffers are chained and only released in TaskQueueDestroy.
+typedef std::int64_t taskq_idx;
+
+typedef struct TaskQueueArrayStruct {
+  taskq_idx mask; // capacity - 1, capacity is always a power of two
+  struct TaskQueueArrayStruct *retired; // the buffer this one replaced, kept alive for concurrent thieves
+  std::atomic<void *> data[1];
+} *TaskQueueArray;
+
 typedef struct TaskQueueStruct {
-  taskq_idx head; // This pointer indicates the first task in the queue
-  taskq_idx tail; // The tail indicates the array element next to the last available task in the queue. So, if head == tail, the queue is empty
-  void *data[TaskQueueSize];
+  alignas(CMI_CACHE_LINE_SIZE) std::atomic<taskq_idx> head; // This index indicates the first task in the queue
+  alignas(CMI_CACHE_LINE_SIZE) std::atomic<taskq_idx> tail; // The tail indicates the array element next to the last available task in the queue. So, if head == tail, the queue is empty
+  std::atomic<TaskQueueArray> array;
 } *TaskQueue;
 
+inline static TaskQueueArray TaskQueueArrayCreate(taskq_idx capacity) {
+  TaskQueueArray a = (TaskQueueArray)malloc(sizeof(struct TaskQueueArrayStruct) + (capacity - 1) * sizeof(std::atomic<void *>));
+  a->mask = capacity - 1;
+  a->retired = NULL;
+  for (taskq_idx i = 0; i < capacity; ++i)
+    std::atomic_store_explicit(&a->data[i], (void *)NULL, std::memory_order_relaxed);
+  return a;
+}
+
 inline static TaskQueue TaskQueueCreate() {
   TaskQueue t = (TaskQueue)malloc(sizeof(struct TaskQueueStruct));
-  t->head = 0;
-  t->tail = 0;
+  std::atomic_store_explicit(&t->head, (taskq_idx)0, std::memory_order_relaxed);
+  std::atomic_store_explicit(&t->tail, (taskq_idx)0, std::memory_order_relaxed);
+  std::atomic_store_explicit(&t->array, TaskQueueArrayCreate(TaskQueueInitSize), std::memory_order_relaxed);
   return t;
 }
 
-inline static void TaskQueuePush(TaskQueue Q, void *data) {
-  Q->data[ Q->tail % TaskQueueSize] = data;
-  CmiMemoryWriteFence();
-  Q->tail +=1;
+// Must only be called once no other thread can access the queue anymore.
+inline static void TaskQueueDestroy(TaskQueue Q) {
+  TaskQueueArray a = std::atomic_load_explicit(&Q->array, std::memory_order_relaxed);
+  while (a != NULL) {
+    TaskQueueArray next = a->retired;
+    free(a);
+    a = next;
+  }
+  free(Q);
 }
 
-inline static void* TaskQueuePop(TaskQueue Q) { // Pop happens in the same worker thread which pushed the task before.
-  TaskQueueDebug("[%d] TaskQueuePop head %d tail %d\n", CmiMyPe(), Q->head, Q->tail);
-  taskq_idx h, t;
-  t = Q->tail -1;
-  Q->tail = t;
-  CmiMemoryWriteFence();
-  h = Q->head;
-  if (t > h) { // This means there are more than two tasks in the queue, so it is safe to pop a task from the queue.
-    TaskQueueDebug("[%d] returning valid data\n", CmiMyPe());
-    return Q->data[t % TaskQueueSize];
-  }
+// Number of tasks currently in the queue. Only a hint when thieves are active.
+inline static taskq_idx TaskQueueLength(TaskQueue Q) {
+  taskq_idx t = std::atomic_load_explicit(&Q->tail, std::memory_order_relaxed);
+  taskq_idx h = std::atomic_load_explicit(&Q->head, std::memory_order_relaxed);
+  return (t > h) ? t - h : 0;
+}
 
+// Called only by the owner when the buffer is full.
+inline static TaskQueueArray TaskQueueGrow(TaskQueue Q, TaskQueueArray a, taskq_idx h, taskq_idx t) {
+  TaskQueueArray b = TaskQueueArrayCreate(2 * (a->mask + 1));
+  TaskQueueDebug("[%d] TaskQueueGrow to %lld slots\n", CmiMyPe(), (long long)(b->mask + 1));
+  for (taskq_idx i = h; i < t; ++i)
+    std::atomic_store_explicit(&b->data[i & b->mask],
+        std::atomic_load_explicit(&a->data[i & a->mask], std::memory_order_relaxed),
+        std::memory_order_relaxed);
+  b->retired = a;
+  std::atomic_store_explicit(&Q->array, b, std::memory_order_release);
+  return b;
+}
+
+inline static void TaskQueuePush(TaskQueue Q, void *data) { // Push happens only in the worker thread owning this queue.
+  taskq_idx t = std::atomic_load_explicit(&Q->tail, std::memory_order_relaxed);
+  taskq_idx h = std::atomic_load_explicit(&Q->head, std::memory_order_acquire);
+  TaskQueueArray a = std::atomic_load_explicit(&Q->array, std::memory_order_relaxed);
+  if (t - h > a->mask) // The buffer is full, so double it before writing.
+    a = TaskQueueGrow(Q, a, h, t);
+  std::atomic_store_explicit(&a->data[t & a->mask], data, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  std::atomic_store_explicit(&Q->tail, t + 1, std::memory_order_relaxed);
+}
+
+inline static void* TaskQueuePop(TaskQueue Q) { // Pop happens in the same worker thread which pushed the task before.
+  taskq_idx t = std::atomic_load_explicit(&Q->tail, std::memory_order_relaxed) - 1;
+  TaskQueueArray a = std::atomic_load_explicit(&Q->array, std::memory_order_relaxed);
+  std::atomic_store_explicit(&Q->tail, t, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  taskq_idx h = std::atomic_load_explicit(&Q->head, std::memory_order_relaxed);
+  TaskQueueDebug("[%d] TaskQueuePop head %lld tail %lld\n", CmiMyPe(), (long long)h, (long long)t);
   if (t < h) { // The taskqueue is empty and the last task has been stolen by a thief.
-    Q->tail = h;
+    std::atomic_store_explicit(&Q->tail, h, std::memory_order_relaxed);
     return NULL;
   }
+  void *data = std::atomic_load_explicit(&a->data[t & a->mask], std::memory_order_relaxed);
+  if (t > h) // This means there are at least two tasks in the queue, so it is safe to pop a task from the queue.
+    return data;
   // From now on, we should handle the situation where there is only one task so thieves and victim can try to obtain this task simultaneously.
-  Q->tail = h + 1;
-#ifdef _WIN32
-  if (h != InterlockedCompareExchange(&(Q->head), h+1,h))
-#else
-  if (!__sync_bool_compare_and_swap(&(Q->head), h, h+1)) // Check whether the last task has already stolen.
-#endif
-    return NULL;
-  return Q->data[t % TaskQueueSize];
+  if (!std::atomic_compare_exchange_strong_explicit(&Q->head, &h, h + 1,
+        std::memory_order_seq_cst, std::memory_order_relaxed)) // Check whether the last task has already been stolen.
+    data = NULL;
+  std::atomic_store_explicit(&Q->tail, t + 1, std::memory_order_relaxed);
+  return data;
 }
 
 inline static void* TaskQueueSteal(TaskQueue Q) {
-  taskq_idx h, t;
-  void *task;
   while (1) {
-    h = Q->head;
-    t = Q->tail;
+    taskq_idx h = std::atomic_load_explicit(&Q->head, std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    taskq_idx t = std::atomic_load_explicit(&Q->tail, std::memory_order_acquire);
     if (h >= t) // The queue is empty or the last element has been stolen by other thieves or popped by the victim.
       return NULL;
-#ifdef _WIN32
-    if (h != InterlockedCompareExchange(&(Q->head), h+1, h))
-#else
-    if (!__sync_bool_compare_and_swap(&(Q->head), h, h+1)) // Check whether the task this thief is trying to steal is still in the queue and not stolen by the other thieves.
-#endif
-      continue;
-    return Q->data[h % TaskQueueSize];
+    TaskQueueArray a = std::atomic_load_explicit(&Q->array, std::memory_order_acquire);
+    void *data = std::atomic_load_explicit(&a->data[h & a->mask], std::memory_order_relaxed);
+    if (std::atomic_compare_exchange_strong_explicit(&Q->head, &h, h + 1,
+          std::memory_order_seq_cst, std::memory_order_relaxed)) // Check whether the task this thief is trying to steal is still in the queue and not stolen by the other thieves.
+      return data;
+  }
+}
+
+// Steals up to half of the tasks visible in Q (at least one, at most max) into out,
+// returning how many were taken. Each task is claimed by its own CAS on head, so the
+// owner can keep popping from the tail concurrently.
+inline static int TaskQueueStealHalf(TaskQueue Q, void **out, int max) {
+  taskq_idx avail = TaskQueueLength(Q);
+  int want = (int)((avail + 1) / 2);
+  if (want > max)
+    want = max;
+  int n = 0;
+  while (n < want) {
+    void *data = TaskQueueSteal(Q);
+    if (data == NULL)
+      break;
+    out[n++] = data;
   }
+  return n;
 }
 
 #endif
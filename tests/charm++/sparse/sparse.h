@@ -1,8 +1,15 @@
+#include <functional>
+#include <map>
 #include "sparse.decl.h"
 
+typedef CkKeyedReducer<int, int, std::plus<int> > KeyedSum;
+extern CkReduction::reducerType keyedSum;
+extern CkReduction::reducerType keyedSumStreamed;
+
 class Main : public CBase_Main {
   private:
     int expected; 
+    std::map<int, int> expectedKeyed;
   public:
     Main_SDAG_CODE
     Main(CkArgMsg*);
@@ -15,6 +22,8 @@ class Main : public CBase_Main {
     void test4D(CkArrayOptions options);
     void test5D(CkArrayOptions options);
     void test6D(CkArrayOptions options);
+    void testKeyed(CkArrayOptions options, CkReduction::reducerType type);
+    void checkKeyed(CkReductionMsg* msg);
 };
 
 class Array1D : public CBase_Array1D {
@@ -29,6 +38,7 @@ class Array2D : public CBase_Array2D {
     Array2D();
     Array2D(CkMigrateMessage* msg) {}
     void ping();
+    void pingKeyed(CkReduction::reducerType type);
 };
 
 class Array3D : public CBase_Array3D {